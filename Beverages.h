@@ -1,11 +1,13 @@
 ﻿#pragma once
 
+#include <stdexcept>
 #include <utility>
 
 #include "IBeverage.h"
+#include "NodePool.h"
 
 // Базовая реализация напитка, предоставляющая его описание
-class CBeverage : public IBeverage
+class CBeverage : public IBeverage, public CPooledAllocation
 {
 public:
 	explicit CBeverage(std::string description)
@@ -134,6 +136,7 @@ public:
             case MilkshakeSize::Small:  return 50;
             case MilkshakeSize::Medium: return 60;
             case MilkshakeSize::Large:  return 80;
+            default:                    throw std::invalid_argument("Unknown milkshake size");
         }
     }
 private:
@@ -1,9 +1,10 @@
 ﻿#pragma once
 
 #include "IBeverage.h"
+#include "NodePool.h"
 
 // Базовый декоратор "Добавка к напитку". Также является напитком
-class CCondimentDecorator : public IBeverage
+class CCondimentDecorator : public IBeverage, public CPooledAllocation
 {
 public:
 	std::string GetDescription()const override
@@ -18,9 +19,17 @@ public:
 		return m_beverage->GetCost() + GetCondimentCost();
 	}
 
-	// Стоимость и описание добавки вычисляется в классах конкретных декораторов
+	void AddIngredients(CRecipe & recipe)const override
+	{
+		// Рецепт складывается из рецепта декорируемого напитка и ингредиентов добавки
+		m_beverage->AddIngredients(recipe);
+		AddCondimentIngredients(recipe);
+	}
+
+	// Стоимость, описание и ингредиенты добавки вычисляются в классах конкретных декораторов
 	virtual std::string GetCondimentDescription()const = 0;
 	virtual double GetCondimentCost()const = 0;
+	virtual void AddCondimentIngredients(CRecipe & recipe)const = 0;
 protected:
 	explicit CCondimentDecorator(IBeveragePtr && beverage)
 		: m_beverage(std::move(beverage))
@@ -47,6 +56,11 @@ protected:
 	{
 		return "Cinnamon";
 	}
+
+	void AddCondimentIngredients(CRecipe & recipe)const override
+	{
+		recipe.Add(Ingredient::Cinnamon, 1);
+	}
 };
 
 // Лимонная добавка
@@ -66,6 +80,10 @@ protected:
 	{
 		return "Lemon x " + std::to_string(m_quantity);
 	}
+	void AddCondimentIngredients(CRecipe & recipe)const override
+	{
+		recipe.Add(Ingredient::Lemon, m_quantity);
+	}
 private:
 	unsigned m_quantity;
 };
@@ -99,6 +117,10 @@ protected:
 		return std::string(m_type == IceCubeType::Dry ? "Dry" : "Water") 
 			+ " ice cubes x " + std::to_string(m_quantity);
 	}
+	void AddCondimentIngredients(CRecipe & recipe)const override
+	{
+		recipe.Add(m_type == IceCubeType::Dry ? Ingredient::DryIceCubes : Ingredient::WaterIceCubes, m_quantity);
+	}
 private:
 	unsigned m_quantity;
 	IceCubeType m_type;
@@ -129,6 +151,10 @@ protected:
 		return std::string(m_syrupType == SyrupType::Chocolate ? "Chocolate" : "Maple") 
 			+ " syrup";
 	}
+	void AddCondimentIngredients(CRecipe & recipe)const override
+	{
+		recipe.Add(m_syrupType == SyrupType::Chocolate ? Ingredient::ChocolateSyrup : Ingredient::MapleSyrup, 1);
+	}
 private:
 	SyrupType m_syrupType;
 };
@@ -152,6 +178,11 @@ public:
 	{
 		return "Chocolate crumbs " + std::to_string(m_mass) + "g";
 	}
+
+	void AddCondimentIngredients(CRecipe & recipe)const override
+	{
+		recipe.Add(Ingredient::ChocolateCrumbs, m_mass);
+	}
 private:
 	unsigned m_mass;
 };
@@ -174,6 +205,10 @@ protected:
 	{
 		return "Coconut flakes " + std::to_string(m_mass) + "g";
 	}
+	void AddCondimentIngredients(CRecipe & recipe)const override
+	{
+		recipe.Add(Ingredient::CoconutFlakes, m_mass);
+	}
 private:
 	unsigned m_mass;
 };
@@ -189,6 +224,10 @@ public:
     double GetCondimentCost() const override {
         return 25;
     }
+
+    void AddCondimentIngredients(CRecipe & recipe) const override {
+        recipe.Add(Ingredient::Cream, 1);
+    }
 };
 
 class CChocolateSlices : public CCondimentDecorator {
@@ -204,6 +243,10 @@ public:
         return 10.0 * m_slices;
     }
 
+    void AddCondimentIngredients(CRecipe & recipe) const override {
+        recipe.Add(Ingredient::ChocolateSlices, m_slices);
+    }
+
 private:
     unsigned m_slices;
 };
@@ -241,6 +284,11 @@ public:
         return 50;
     }
 
+    void AddCondimentIngredients(CRecipe & recipe) const override
+    {
+        recipe.Add(m_type == LiqueurType::Nutty ? Ingredient::NuttyLiqueur : Ingredient::ChocolateLiqueur, 1);
+    }
+
 private:
     LiqueurType m_type;
 };
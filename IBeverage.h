@@ -3,6 +3,8 @@
 #include <string>
 #include <memory>
 
+#include "Ingredients.h"
+
 
 // Интерфейс "напиток"
 class IBeverage
@@ -10,6 +12,8 @@ class IBeverage
 public:
 	virtual std::string GetDescription() const = 0;
 	virtual double GetCost()const = 0;
+	// Добавляет в рецепт ингредиенты, расходуемые на приготовление напитка
+	virtual void AddIngredients(CRecipe & /*recipe*/)const {}
 	virtual ~IBeverage() = default;
 };
 
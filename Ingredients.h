@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include <array>
+#include <string>
+
+// Ингредиенты, запас которых учитывается на складе
+enum class Ingredient
+{
+    Lemon,              // дольки
+    Cinnamon,           // порции
+    WaterIceCubes,      // кубики
+    DryIceCubes,        // кубики
+    ChocolateSyrup,     // порции
+    MapleSyrup,         // порции
+    ChocolateCrumbs,    // граммы
+    CoconutFlakes,      // граммы
+    Cream,              // порции
+    ChocolateSlices,    // дольки
+    NuttyLiqueur,       // порции
+    ChocolateLiqueur,   // порции
+};
+
+const size_t INGREDIENTS_COUNT = static_cast<size_t>(Ingredient::ChocolateLiqueur) + 1;
+
+inline std::string ToString(Ingredient ingredient)
+{
+    switch (ingredient)
+    {
+        case Ingredient::Lemon:            return "Lemon";
+        case Ingredient::Cinnamon:         return "Cinnamon";
+        case Ingredient::WaterIceCubes:    return "Water ice cubes";
+        case Ingredient::DryIceCubes:      return "Dry ice cubes";
+        case Ingredient::ChocolateSyrup:   return "Chocolate syrup";
+        case Ingredient::MapleSyrup:       return "Maple syrup";
+        case Ingredient::ChocolateCrumbs:  return "Chocolate crumbs";
+        case Ingredient::CoconutFlakes:    return "Coconut flakes";
+        case Ingredient::Cream:            return "Cream";
+        case Ingredient::ChocolateSlices:  return "Chocolate slices";
+        case Ingredient::NuttyLiqueur:     return "Nutty liqueur";
+        case Ingredient::ChocolateLiqueur: return "Chocolate liqueur";
+        default:                           return "Unknown Ingredient";
+    }
+}
+
+// Рецепт - количество каждого ингредиента, расходуемого на приготовление напитка
+class CRecipe
+{
+public:
+    void Add(Ingredient ingredient, unsigned amount)
+    {
+        m_amounts[static_cast<size_t>(ingredient)] += amount;
+    }
+
+    unsigned GetAmount(Ingredient ingredient) const
+    {
+        return m_amounts[static_cast<size_t>(ingredient)];
+    }
+private:
+    std::array<unsigned, INGREDIENTS_COUNT> m_amounts{};
+};
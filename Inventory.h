@@ -0,0 +1,381 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "Ingredients.h"
+
+class CInventory;
+
+// Сводка по складу, снятая в один момент времени
+struct InventorySnapshot
+{
+    std::array<unsigned long long, INGREDIENTS_COUNT> available{};  // можно зарезервировать
+    std::array<unsigned long long, INGREDIENTS_COUNT> consumed{};   // израсходовано на выданные заказы
+
+    unsigned long long GetAvailable(Ingredient ingredient) const
+    {
+        return available[static_cast<size_t>(ingredient)];
+    }
+
+    unsigned long long GetConsumed(Ingredient ingredient) const
+    {
+        return consumed[static_cast<size_t>(ingredient)];
+    }
+};
+
+/*
+Резерв ингредиентов под один заказ.
+Пока резерв не подтвержден вызовом Commit, ингредиенты недоступны другим заказам;
+неподтвержденный резерв при разрушении возвращает ингредиенты на склад.
+*/
+class CInventoryReservation
+{
+public:
+    CInventoryReservation() = default;
+    CInventoryReservation(CInventoryReservation && other) noexcept;
+    CInventoryReservation & operator=(CInventoryReservation && other) noexcept;
+    CInventoryReservation(const CInventoryReservation &) = delete;
+    CInventoryReservation & operator=(const CInventoryReservation &) = delete;
+    ~CInventoryReservation();
+
+    // Резерв удался - ингредиентов на складе хватило
+    explicit operator bool() const
+    {
+        return m_inventory != nullptr;
+    }
+
+    // Заказ выдан - зарезервированные ингредиенты списываются окончательно
+    void Commit();
+    // Заказ отменен - ингредиенты возвращаются на склад
+    void Cancel();
+private:
+    friend class CInventory;
+    static const size_t SHARDS_COUNT = 8;
+    typedef std::array<std::array<unsigned, SHARDS_COUNT>, INGREDIENTS_COUNT> Amounts;
+
+    explicit CInventoryReservation(CInventory & inventory)
+        : m_inventory(&inventory)
+    {}
+
+    CInventory * m_inventory = nullptr;
+    Amounts m_taken{};  // сколько каждого ингредиента взято из каждого шарда
+};
+
+/*
+Склад ингредиентов, рассчитанный на одновременное оформление заказов из многих потоков.
+
+Запас каждого ингредиента разбит между шардами, каждый шард лежит в своей кэш-линии.
+Поток резервирует ингредиенты в "своем" шарде и обращается к чужим, только когда
+в своем закончился запас, поэтому параллельные кассы почти не конкурируют за память.
+
+Для согласованной сводки GetSnapshot на время подсчета останавливает новые операции
+и дожидается завершения начатых, поэтому частично выполненный резерв в сводку не попадает.
+*/
+class CInventory
+{
+public:
+    static const size_t SHARDS_COUNT = CInventoryReservation::SHARDS_COUNT;
+
+    CInventory() = default;
+    CInventory(const CInventory &) = delete;
+    CInventory & operator=(const CInventory &) = delete;
+
+    // Добавляет ингредиент на склад, распределяя его поровну между шардами
+    void Restock(Ingredient ingredient, unsigned long long amount)
+    {
+        COperationGuard guard(*this);
+        auto index = static_cast<size_t>(ingredient);
+        for (size_t shard = 0; shard < SHARDS_COUNT; ++shard)
+        {
+            auto share = amount / SHARDS_COUNT + (shard < amount % SHARDS_COUNT ? 1 : 0);
+            m_shards[shard].available[index].fetch_add(share);
+        }
+    }
+
+    /*
+    Резервирует все ингредиенты рецепта или ни одного.
+    Пустой (ложный) резерв возвращается, только если какого-то ингредиента на складе
+    действительно не хватает.
+
+    Перед списанием проверяется суммарный запас по всем шардам вместе с ингредиентами,
+    которые прямо сейчас забирают другие резервы, поэтому заказ, на который заведомо
+    не хватает ингредиентов, не трогает склад и не мешает другим. Если запаса хватало,
+    но его разобрали параллельные заказы, пока резерв обходил шарды (или ингредиенты
+    вернулись в уже пройденный шард), взятое возвращается и попытка повторяется.
+    */
+    CInventoryReservation Reserve(const CRecipe & recipe)
+    {
+        for (;;)
+        {
+            {
+                COperationGuard guard(*this);
+                if (!HasEnough(recipe))
+                {
+                    return CInventoryReservation();
+                }
+                CInventoryReservation reservation(*this);
+                bool isTaken = TryTake(recipe, reservation.m_taken);
+                if (!isTaken)
+                {
+                    Return(reservation.m_taken);
+                }
+                ClearPending(reservation.m_taken);
+                if (isTaken)
+                {
+                    return reservation;
+                }
+                reservation.m_inventory = nullptr;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    InventorySnapshot GetSnapshot()
+    {
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        m_isFrozen.store(true);
+        for (auto & shard : m_shards)
+        {
+            while (shard.activeOperations.load() != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        InventorySnapshot snapshot;
+        for (auto & shard : m_shards)
+        {
+            for (size_t index = 0; index < INGREDIENTS_COUNT; ++index)
+            {
+                snapshot.available[index] += shard.available[index].load();
+                snapshot.consumed[index] += shard.consumed[index].load();
+            }
+        }
+        m_isFrozen.store(false);
+        return snapshot;
+    }
+private:
+    friend class CInventoryReservation;
+    typedef std::atomic<unsigned long long> Counter;
+
+    struct alignas(64) Shard
+    {
+        std::array<Counter, INGREDIENTS_COUNT> available{};
+        std::array<Counter, INGREDIENTS_COUNT> consumed{};
+        // Взято резервами, которые еще обходят шарды и могут вернуть взятое
+        std::array<Counter, INGREDIENTS_COUNT> pending{};
+        std::atomic<unsigned> activeOperations{0};
+    };
+
+    /*
+    Отмечает операцию над складом в шарде текущего потока.
+    Пока идет подсчет сводки, новые операции ждут его окончания.
+    */
+    class COperationGuard
+    {
+    public:
+        explicit COperationGuard(CInventory & inventory)
+            : m_activeOperations(inventory.m_shards[GetHomeShard()].activeOperations)
+        {
+            for (;;)
+            {
+                m_activeOperations.fetch_add(1);
+                if (!inventory.m_isFrozen.load())
+                {
+                    return;
+                }
+                m_activeOperations.fetch_sub(1);
+                while (inventory.m_isFrozen.load())
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        ~COperationGuard()
+        {
+            m_activeOperations.fetch_sub(1);
+        }
+        COperationGuard(const COperationGuard &) = delete;
+        COperationGuard & operator=(const COperationGuard &) = delete;
+    private:
+        std::atomic<unsigned> & m_activeOperations;
+    };
+
+    // Потоки закрепляются за шардами по кругу при первом обращении к складу
+    static size_t GetHomeShard()
+    {
+        static std::atomic<size_t> nextShard{0};
+        thread_local size_t homeShard = nextShard.fetch_add(1) % SHARDS_COUNT;
+        return homeShard;
+    }
+
+    /*
+    Хватает ли запаса с учетом ингредиентов, которые держат незавершенные попытки резерва.
+    TryTake сначала увеличивает pending, потом уменьшает available, а при откате наоборот
+    сначала увеличивает available, потом уменьшает pending. Чтение pending до и после available
+    гарантирует, что ингредиент в пути посчитан хотя бы один раз.
+    */
+    bool HasEnough(const CRecipe & recipe) const
+    {
+        for (size_t index = 0; index < INGREDIENTS_COUNT; ++index)
+        {
+            unsigned long long needed = recipe.GetAmount(static_cast<Ingredient>(index));
+            unsigned long long available = 0;
+            for (size_t shard = 0; shard < SHARDS_COUNT && available < needed; ++shard)
+            {
+                auto & counters = m_shards[shard];
+                auto pendingBefore = counters.pending[index].load();
+                auto shardAvailable = counters.available[index].load();
+                auto pendingAfter = counters.pending[index].load();
+                available += shardAvailable + std::max(pendingBefore, pendingAfter);
+            }
+            if (available < needed)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+    Обходит шарды, начиная со своего; false - какого-то ингредиента не хватило.
+    Взятое учитывается в pending, пока вызывающий код не завершит попытку через ClearPending.
+    */
+    bool TryTake(const CRecipe & recipe, CInventoryReservation::Amounts & taken)
+    {
+        auto home = GetHomeShard();
+        for (size_t index = 0; index < INGREDIENTS_COUNT; ++index)
+        {
+            unsigned remaining = recipe.GetAmount(static_cast<Ingredient>(index));
+            for (size_t i = 0; i < SHARDS_COUNT && remaining != 0; ++i)
+            {
+                auto shard = (home + i) % SHARDS_COUNT;
+                auto & counters = m_shards[shard];
+                counters.pending[index].fetch_add(remaining);
+                auto amount = Take(counters.available[index], remaining);
+                if (amount != remaining)
+                {
+                    counters.pending[index].fetch_sub(remaining - amount);
+                }
+                taken[index][shard] += amount;
+                remaining -= amount;
+            }
+            if (remaining != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Забирает из счетчика не больше amount, возвращает сколько удалось взять
+    static unsigned Take(Counter & counter, unsigned amount)
+    {
+        auto current = counter.load();
+        unsigned long long taken = 0;
+        do
+        {
+            taken = current < amount ? current : amount;
+        } while (taken != 0 && !counter.compare_exchange_weak(current, current - taken));
+        return static_cast<unsigned>(taken);
+    }
+
+    void Return(const CInventoryReservation::Amounts & taken)
+    {
+        for (size_t index = 0; index < INGREDIENTS_COUNT; ++index)
+        {
+            for (size_t shard = 0; shard < SHARDS_COUNT; ++shard)
+            {
+                if (taken[index][shard] != 0)
+                {
+                    m_shards[shard].available[index].fetch_add(taken[index][shard]);
+                }
+            }
+        }
+    }
+
+    void ClearPending(const CInventoryReservation::Amounts & taken)
+    {
+        for (size_t index = 0; index < INGREDIENTS_COUNT; ++index)
+        {
+            for (size_t shard = 0; shard < SHARDS_COUNT; ++shard)
+            {
+                if (taken[index][shard] != 0)
+                {
+                    m_shards[shard].pending[index].fetch_sub(taken[index][shard]);
+                }
+            }
+        }
+    }
+
+    void Consume(const CInventoryReservation::Amounts & taken)
+    {
+        COperationGuard guard(*this);
+        for (size_t index = 0; index < INGREDIENTS_COUNT; ++index)
+        {
+            for (size_t shard = 0; shard < SHARDS_COUNT; ++shard)
+            {
+                if (taken[index][shard] != 0)
+                {
+                    m_shards[shard].consumed[index].fetch_add(taken[index][shard]);
+                }
+            }
+        }
+    }
+
+    void Release(const CInventoryReservation::Amounts & taken)
+    {
+        COperationGuard guard(*this);
+        Return(taken);
+    }
+
+    std::array<Shard, SHARDS_COUNT> m_shards;
+    std::atomic<bool> m_isFrozen{false};
+    std::mutex m_snapshotMutex;
+};
+
+inline CInventoryReservation::CInventoryReservation(CInventoryReservation && other) noexcept
+    : m_inventory(other.m_inventory)
+    , m_taken(other.m_taken)
+{
+    other.m_inventory = nullptr;
+}
+
+inline CInventoryReservation & CInventoryReservation::operator=(CInventoryReservation && other) noexcept
+{
+    if (this != &other)
+    {
+        Cancel();
+        m_inventory = other.m_inventory;
+        m_taken = other.m_taken;
+        other.m_inventory = nullptr;
+    }
+    return *this;
+}
+
+inline CInventoryReservation::~CInventoryReservation()
+{
+    Cancel();
+}
+
+inline void CInventoryReservation::Commit()
+{
+    if (m_inventory)
+    {
+        m_inventory->Consume(m_taken);
+        m_inventory = nullptr;
+    }
+}
+
+inline void CInventoryReservation::Cancel()
+{
+    if (m_inventory)
+    {
+        m_inventory->Release(m_taken);
+        m_inventory = nullptr;
+    }
+}
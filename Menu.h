@@ -0,0 +1,181 @@
+﻿#pragma once
+
+#include <array>
+
+#include "Beverages.h"
+#include "Condiments.h"
+
+// Варианты базовых напитков из меню кафе
+enum class BaseBeverageOption
+{
+    Coffee,
+    StandardCappuccino,
+    DoubleCappuccino,
+    StandardLatte,
+    DoubleLatte,
+    BlackTea,
+    WhiteTea,
+    BlueTea,
+    CyanTea,
+    SmallMilkshake,
+    MediumMilkshake,
+    LargeMilkshake,
+};
+
+const size_t BASE_BEVERAGE_OPTIONS_COUNT = static_cast<size_t>(BaseBeverageOption::LargeMilkshake) + 1;
+
+// Варианты добавок из меню (в тех же порциях, что предлагает MakeCondimentChoice)
+enum class CondimentOption
+{
+    Lemon,              // 2 дольки
+    Cinnamon,
+    WaterIceCubes,      // 2 кубика
+    DryIceCubes,        // 2 кубика
+    ChocolateCrumbs,    // 5 г
+    CoconutFlakes,      // 5 г
+    MapleSyrup,
+    ChocolateSyrup,
+    Cream,
+    NuttyLiqueur,
+    ChocolateLiqueur,
+    ChocolateSlices,    // 1 долька
+};
+
+const size_t CONDIMENT_OPTIONS_COUNT = static_cast<size_t>(CondimentOption::ChocolateSlices) + 1;
+
+// Заказ из меню: базовый напиток и количество каждой добавки (порядок добавок не важен)
+struct MenuOrder
+{
+    BaseBeverageOption base = BaseBeverageOption::Coffee;
+    std::array<unsigned, CONDIMENT_OPTIONS_COUNT> condiments{};
+
+    MenuOrder & Add(CondimentOption condiment, unsigned count = 1)
+    {
+        condiments[static_cast<size_t>(condiment)] += count;
+        return *this;
+    }
+
+    unsigned GetCondimentsCount() const
+    {
+        unsigned count = 0;
+        for (auto condimentCount : condiments)
+        {
+            count += condimentCount;
+        }
+        return count;
+    }
+};
+
+/*
+Вариант базового напитка по ответам покупателя, которые MakeBeverageChoice получает в диалоге:
+beverageChoice - номер напитка (1..5), variantChoice - номер порции, сорта чая или размера.
+Для капучино и латте принимаются ответы 1..4, и все, кроме 1, - двойная порция.
+Возвращает false, если выбор недопустим.
+*/
+inline bool GetBaseBeverageOption(int beverageChoice, int variantChoice, BaseBeverageOption & option)
+{
+    switch (beverageChoice)
+    {
+        case 1:
+            option = BaseBeverageOption::Coffee;
+            return true;
+        case 2:
+        case 3:
+            if (variantChoice > 4 || variantChoice < 1)
+            {
+                return false;
+            }
+            if (beverageChoice == 2)
+            {
+                option = variantChoice == 1 ? BaseBeverageOption::StandardCappuccino : BaseBeverageOption::DoubleCappuccino;
+            }
+            else
+            {
+                option = variantChoice == 1 ? BaseBeverageOption::StandardLatte : BaseBeverageOption::DoubleLatte;
+            }
+            return true;
+        case 4:
+            if (variantChoice > 4 || variantChoice < 1)
+            {
+                return false;
+            }
+            option = static_cast<BaseBeverageOption>(static_cast<int>(BaseBeverageOption::BlackTea) + variantChoice - 1);
+            return true;
+        case 5:
+            if (variantChoice > 3 || variantChoice < 1)
+            {
+                return false;
+            }
+            option = static_cast<BaseBeverageOption>(static_cast<int>(BaseBeverageOption::SmallMilkshake) + variantChoice - 1);
+            return true;
+        default:
+            return false;
+    }
+}
+
+inline IBeveragePtr MakeBaseBeverage(BaseBeverageOption option)
+{
+    switch (option)
+    {
+        case BaseBeverageOption::Coffee:             return std::make_unique<CCoffee>();
+        case BaseBeverageOption::StandardCappuccino: return std::make_unique<CCappuccino>(false);
+        case BaseBeverageOption::DoubleCappuccino:   return std::make_unique<CCappuccino>(true);
+        case BaseBeverageOption::StandardLatte:      return std::make_unique<CLatte>(false);
+        case BaseBeverageOption::DoubleLatte:        return std::make_unique<CLatte>(true);
+        case BaseBeverageOption::BlackTea:           return std::make_unique<CTea>(TeaType::Black);
+        case BaseBeverageOption::WhiteTea:           return std::make_unique<CTea>(TeaType::White);
+        case BaseBeverageOption::BlueTea:            return std::make_unique<CTea>(TeaType::Blue);
+        case BaseBeverageOption::CyanTea:            return std::make_unique<CTea>(TeaType::Cyan);
+        case BaseBeverageOption::SmallMilkshake:     return std::make_unique<CMilkshake>(MilkshakeSize::Small);
+        case BaseBeverageOption::MediumMilkshake:    return std::make_unique<CMilkshake>(MilkshakeSize::Medium);
+        case BaseBeverageOption::LargeMilkshake:     return std::make_unique<CMilkshake>(MilkshakeSize::Large);
+        default:                                     return nullptr;
+    }
+}
+
+inline IBeveragePtr AddCondiment(IBeveragePtr && beverage, CondimentOption option)
+{
+    switch (option)
+    {
+        case CondimentOption::Lemon:
+            return std::make_unique<CLemon>(std::move(beverage), 2);
+        case CondimentOption::Cinnamon:
+            return std::make_unique<CCinnamon>(std::move(beverage));
+        case CondimentOption::WaterIceCubes:
+            return std::make_unique<CIceCubes>(std::move(beverage), 2, IceCubeType::Water);
+        case CondimentOption::DryIceCubes:
+            return std::make_unique<CIceCubes>(std::move(beverage), 2, IceCubeType::Dry);
+        case CondimentOption::ChocolateCrumbs:
+            return std::make_unique<CChocolateCrumbs>(std::move(beverage), 5);
+        case CondimentOption::CoconutFlakes:
+            return std::make_unique<CCoconutFlakes>(std::move(beverage), 5);
+        case CondimentOption::MapleSyrup:
+            return std::make_unique<CSyrup>(std::move(beverage), SyrupType::Maple);
+        case CondimentOption::ChocolateSyrup:
+            return std::make_unique<CSyrup>(std::move(beverage), SyrupType::Chocolate);
+        case CondimentOption::Cream:
+            return std::make_unique<CCream>(std::move(beverage));
+        case CondimentOption::NuttyLiqueur:
+            return std::make_unique<CLiqueur>(std::move(beverage), LiqueurType::Nutty);
+        case CondimentOption::ChocolateLiqueur:
+            return std::make_unique<CLiqueur>(std::move(beverage), LiqueurType::Chocolate);
+        case CondimentOption::ChocolateSlices:
+            return std::make_unique<CChocolateSlices>(std::move(beverage), 1);
+        default:
+            return std::move(beverage);
+    }
+}
+
+// Собирает цепочку декораторов заказа; добавки оборачиваются в порядке CondimentOption
+inline IBeveragePtr MakeBeverage(const MenuOrder & order)
+{
+    auto beverage = MakeBaseBeverage(order.base);
+    for (size_t option = 0; option < CONDIMENT_OPTIONS_COUNT && beverage; ++option)
+    {
+        for (unsigned i = 0; i < order.condiments[option]; ++i)
+        {
+            beverage = AddCondiment(std::move(beverage), static_cast<CondimentOption>(option));
+        }
+    }
+    return beverage;
+}
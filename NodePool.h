@@ -0,0 +1,152 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <new>
+
+// Под AddressSanitizer пул отключается: блоки из списка свободных ASan считает живыми
+// и не видит обращений к уже удаленным узлам
+#ifndef BEVERAGE_POOL_DISABLED
+#if defined(__SANITIZE_ADDRESS__)
+#define BEVERAGE_POOL_DISABLED
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define BEVERAGE_POOL_DISABLED
+#endif
+#endif
+#endif
+
+/*
+Пул памяти для узлов цепочки напиток-декораторы.
+
+После выдачи заказа вся цепочка IBeveragePtr уничтожается, а следующий заказ
+создает узлы тех же классов заново. Пул хранит освободившиеся блоки в списках
+свободных блоков, отдельных для каждого потока и каждого размера узла (размер узла
+однозначно соответствует его классу), и отдает их следующему заказу без обращения
+к системному аллокатору.
+*/
+class CNodePool
+{
+public:
+    // Блоки больше MAX_BLOCK_SIZE пул не обслуживает
+    static const size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+    static const size_t MAX_BLOCK_SIZE = 256;
+    // Сколько свободных блоков каждого размера держит поток, остальные возвращаются в систему
+    static const size_t MAX_FREE_BLOCKS = 1024;
+
+    explicit CNodePool(bool & isDestroyed)
+        : m_isDestroyed(isDestroyed)
+    {}
+    CNodePool(const CNodePool &) = delete;
+    CNodePool & operator=(const CNodePool &) = delete;
+
+    ~CNodePool()
+    {
+        for (auto & freeList : m_freeLists)
+        {
+            while (freeList.head)
+            {
+                auto block = freeList.head;
+                freeList.head = block->next;
+                ::operator delete(block);
+            }
+        }
+        m_isDestroyed = true;
+    }
+
+    // Пул текущего потока. После завершения потока возвращает nullptr
+    static CNodePool * GetThreadPool()
+    {
+        thread_local bool isDestroyed = false;
+        thread_local CNodePool pool(isDestroyed);
+        return isDestroyed ? nullptr : &pool;
+    }
+
+    static void * Allocate(size_t size)
+    {
+        if (size > MAX_BLOCK_SIZE)
+        {
+            return ::operator new(size);
+        }
+        // Блок всегда выделяется полного размера своего класса, так как его может
+        // освободить и переиспользовать узел другого класса того же размера
+        auto pool = GetThreadPool();
+        if (!pool || !pool->m_freeLists[GetSizeClass(size)].head)
+        {
+            return ::operator new(GetBlockSize(size));
+        }
+        auto & freeList = pool->m_freeLists[GetSizeClass(size)];
+        auto block = freeList.head;
+        freeList.head = block->next;
+        --freeList.count;
+        return block;
+    }
+
+    static void Deallocate(void * ptr, size_t size)
+    {
+        auto pool = size <= MAX_BLOCK_SIZE ? GetThreadPool() : nullptr;
+        if (!pool)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        auto & freeList = pool->m_freeLists[GetSizeClass(size)];
+        if (freeList.count == MAX_FREE_BLOCKS)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        auto block = static_cast<Block *>(ptr);
+        block->next = freeList.head;
+        freeList.head = block;
+        ++freeList.count;
+    }
+private:
+    struct Block
+    {
+        Block * next;
+    };
+
+    struct FreeList
+    {
+        Block * head = nullptr;
+        size_t count = 0;
+    };
+
+    static size_t GetSizeClass(size_t size)
+    {
+        return (size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT - 1;
+    }
+
+    static size_t GetBlockSize(size_t size)
+    {
+        return (GetSizeClass(size) + 1) * BLOCK_ALIGNMENT;
+    }
+
+    FreeList m_freeLists[MAX_BLOCK_SIZE / BLOCK_ALIGNMENT];
+    bool & m_isDestroyed;
+};
+
+/*
+Базовый класс, направляющий new/delete наследника в CNodePool.
+Благодаря виртуальному деструктору IBeverage delete через IBeveragePtr получает
+настоящий размер узла, поэтому make_unique, MakeCondiment и оператор << работают
+с пулом без изменений в вызывающем коде.
+
+Если определен BEVERAGE_POOL_DISABLED (для сравнения в бенчмарке и в сборках с ASan),
+узлы создаются обычным new.
+*/
+class CPooledAllocation
+{
+#ifndef BEVERAGE_POOL_DISABLED
+public:
+    static void * operator new(size_t size)
+    {
+        return CNodePool::Allocate(size);
+    }
+
+    static void operator delete(void * ptr, size_t size)
+    {
+        CNodePool::Deallocate(ptr, size);
+    }
+#endif
+};
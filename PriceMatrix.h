@@ -0,0 +1,214 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "Menu.h"
+
+// Цена и описание заказа
+struct PriceQuote
+{
+    double cost = 0;
+    std::string description;
+};
+
+/*
+Заранее рассчитанные цены всех заказов меню, содержащих не более maxCondiments добавок.
+
+Для каждого базового напитка и каждого мультимножества добавок цепочка декораторов
+собирается один раз, ее стоимость и описание сохраняются в отсортированной по ключу
+таблице, так что цена заказа - это один двоичный поиск без создания объектов.
+Описания хранятся в общем буфере строк.
+
+Таблица строится уровнями (0 добавок, 1 добавка, ...); уровень, не поместившийся
+в memoryBudget байт, отбрасывается целиком. Заказы вне таблицы считаются по живой
+цепочке декораторов. Описание соответствует цепочке, в которой добавки идут
+в порядке CondimentOption.
+*/
+class CPriceMatrix
+{
+public:
+    // Количество каждой добавки хранится в ключе в 4 битах
+    static const unsigned MAX_DEPTH = 15;
+
+    explicit CPriceMatrix(unsigned maxCondiments = 3,
+            size_t memoryBudget = std::numeric_limits<size_t>::max())
+        : m_memoryBudget(memoryBudget)
+    {
+        if (maxCondiments > MAX_DEPTH)
+        {
+            maxCondiments = MAX_DEPTH;
+        }
+        for (unsigned depth = 0; depth <= maxCondiments; ++depth)
+        {
+            if (!AddLevel(depth))
+            {
+                break;
+            }
+            m_depth = static_cast<int>(depth);
+        }
+        std::sort(m_entries.begin(), m_entries.end(), [](const Entry & lhs, const Entry & rhs) {
+            return lhs.key < rhs.key;
+        });
+        m_entries.shrink_to_fit();
+        m_descriptions.shrink_to_fit();
+    }
+
+    // Наибольшее число добавок, для которого в таблице есть все заказы (-1 - таблица пуста)
+    int GetDepth() const
+    {
+        return m_depth;
+    }
+
+    size_t GetEntriesCount() const
+    {
+        return m_entries.size();
+    }
+
+    size_t GetMemoryUsage() const
+    {
+        return m_entries.capacity() * sizeof(Entry) + m_descriptions.capacity();
+    }
+
+    bool Contains(const MenuOrder & order) const
+    {
+        return Find(order) != nullptr;
+    }
+
+    // Возвращает false, если такого напитка нет в меню
+    bool GetCost(const MenuOrder & order, double & cost) const
+    {
+        if (auto entry = Find(order))
+        {
+            cost = entry->cost;
+            return true;
+        }
+        auto beverage = MakeBeverage(order);
+        if (!beverage)
+        {
+            return false;
+        }
+        cost = beverage->GetCost();
+        return true;
+    }
+
+    // Возвращает false, если такого напитка нет в меню
+    bool GetQuote(const MenuOrder & order, PriceQuote & quote) const
+    {
+        if (auto entry = Find(order))
+        {
+            quote.cost = entry->cost;
+            quote.description.assign(m_descriptions, entry->descriptionOffset, entry->descriptionLength);
+            return true;
+        }
+        auto beverage = MakeBeverage(order);
+        if (!beverage)
+        {
+            return false;
+        }
+        quote.cost = beverage->GetCost();
+        quote.description = beverage->GetDescription();
+        return true;
+    }
+private:
+    struct Entry
+    {
+        uint64_t key;
+        double cost;
+        uint32_t descriptionOffset;
+        uint32_t descriptionLength;
+    };
+
+    // Ключ: 4 бита на базовый напиток и по 4 бита на количество каждой добавки
+    static uint64_t MakeKey(const MenuOrder & order)
+    {
+        uint64_t key = static_cast<uint64_t>(order.base);
+        for (auto count : order.condiments)
+        {
+            key = (key << 4) | count;
+        }
+        return key;
+    }
+
+    const Entry * Find(const MenuOrder & order) const
+    {
+        if (static_cast<size_t>(order.base) >= BASE_BEVERAGE_OPTIONS_COUNT
+            || static_cast<int>(order.GetCondimentsCount()) > m_depth)
+        {
+            return nullptr;
+        }
+        auto key = MakeKey(order);
+        auto it = std::lower_bound(m_entries.begin(), m_entries.end(), key, [](const Entry & entry, uint64_t key) {
+            return entry.key < key;
+        });
+        return it != m_entries.end() && it->key == key ? &*it : nullptr;
+    }
+
+    // Добавляет в таблицу все заказы ровно с depth добавками, если они укладываются в бюджет
+    bool AddLevel(unsigned depth)
+    {
+        auto entriesCount = m_entries.size();
+        auto descriptionsSize = m_descriptions.size();
+        bool fits = true;
+        for (size_t base = 0; base < BASE_BEVERAGE_OPTIONS_COUNT && fits; ++base)
+        {
+            MenuOrder order;
+            order.base = static_cast<BaseBeverageOption>(base);
+            fits = AddCombinations(order, 0, depth);
+        }
+        if (!fits)
+        {
+            m_entries.resize(entriesCount);
+            m_descriptions.resize(descriptionsSize);
+        }
+        return fits;
+    }
+
+    // Перебирает мультимножества из remaining добавок, начиная с добавки firstOption
+    bool AddCombinations(MenuOrder & order, size_t firstOption, unsigned remaining)
+    {
+        if (remaining == 0)
+        {
+            return AddEntry(order);
+        }
+        for (size_t option = firstOption; option < CONDIMENT_OPTIONS_COUNT; ++option)
+        {
+            ++order.condiments[option];
+            bool fits = AddCombinations(order, option, remaining - 1);
+            --order.condiments[option];
+            if (!fits)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool AddEntry(const MenuOrder & order)
+    {
+        auto beverage = MakeBeverage(order);
+        auto description = beverage->GetDescription();
+        auto memoryUsage = (m_entries.size() + 1) * sizeof(Entry) + m_descriptions.size() + description.size();
+        if (memoryUsage > m_memoryBudget
+            || m_descriptions.size() + description.size() > std::numeric_limits<uint32_t>::max())
+        {
+            return false;
+        }
+        Entry entry;
+        entry.key = MakeKey(order);
+        entry.cost = beverage->GetCost();
+        entry.descriptionOffset = static_cast<uint32_t>(m_descriptions.size());
+        entry.descriptionLength = static_cast<uint32_t>(description.size());
+        m_entries.push_back(entry);
+        m_descriptions += description;
+        return true;
+    }
+
+    size_t m_memoryBudget;
+    int m_depth = -1;
+    std::vector<Entry> m_entries;
+    std::string m_descriptions;
+};
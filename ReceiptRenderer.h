@@ -0,0 +1,196 @@
+﻿#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+#include "IBeverage.h"
+
+// Формат, в котором выписываются чеки
+enum class ReceiptFormat
+{
+    Text,   // "Coffee, Cinnamon, cost: 80" - как при обычной выдаче заказа
+    Csv,    // order,description,cost
+    Json    // [{"order":1,"description":"...","cost":80}, ...]
+};
+
+/*
+Форматирует заказы в один переиспользуемый буфер и выводит их единственной записью в поток.
+
+Вместо `cout << ... << endl` на каждый заказ (сброс буфера потока и временные строки
+на каждой строчке) заказы дописываются в буфер. Стоимость выводится так же, как
+`cout << cost`; целые цены (а в меню других нет) форматируются без участия iostream и printf.
+После WriteTo буфер очищается, но его емкость сохраняется для следующей смены.
+
+Использование:
+    CReceiptRenderer receipt(ReceiptFormat::Csv);
+    receipt.Reserve(ordersCount);
+    for (auto & beverage : orders)
+        receipt.Add(*beverage);
+    receipt.WriteTo(cout);
+*/
+class CReceiptRenderer
+{
+public:
+    explicit CReceiptRenderer(ReceiptFormat format = ReceiptFormat::Text)
+        : m_format(format)
+    {}
+
+    // Резервирует место под ordersCount заказов, чтобы избежать перевыделений буфера
+    void Reserve(size_t ordersCount)
+    {
+        m_buffer.reserve(m_buffer.size() + ordersCount * APPROX_LINE_LENGTH);
+    }
+
+    void Add(const IBeverage & beverage)
+    {
+        Add(beverage.GetDescription(), beverage.GetCost());
+    }
+
+    void Add(const std::string & description, double cost)
+    {
+        ++m_count;
+        switch (m_format)
+        {
+            case ReceiptFormat::Text:
+                m_buffer += description;
+                m_buffer += ", cost: ";
+                AppendCost(cost);
+                m_buffer += '\n';
+                break;
+            case ReceiptFormat::Csv:
+                if (m_count == 1)
+                {
+                    m_buffer += "order,description,cost\n";
+                }
+                AppendUnsigned(m_count);
+                m_buffer += ',';
+                AppendCsvField(description);
+                m_buffer += ',';
+                AppendCost(cost);
+                m_buffer += '\n';
+                break;
+            case ReceiptFormat::Json:
+                m_buffer += m_count == 1 ? "[\n" : ",\n";
+                m_buffer += "{\"order\":";
+                AppendUnsigned(m_count);
+                m_buffer += ",\"description\":";
+                AppendJsonString(description);
+                m_buffer += ",\"cost\":";
+                if (std::isfinite(cost))
+                {
+                    AppendCost(cost);
+                }
+                else
+                {
+                    // В JSON нет записи для nan и inf
+                    m_buffer += "null";
+                }
+                m_buffer += '}';
+                break;
+        }
+    }
+
+    size_t GetOrdersCount() const
+    {
+        return m_count;
+    }
+
+    // Выводит все накопленные заказы одной записью и готовит буфер к следующей порции
+    void WriteTo(std::ostream & out)
+    {
+        if (m_format == ReceiptFormat::Json)
+        {
+            m_buffer += m_count == 0 ? "[]\n" : "\n]\n";
+        }
+        out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        Clear();
+    }
+
+    // Отбрасывает накопленные заказы, сохраняя емкость буфера
+    void Clear()
+    {
+        m_buffer.clear();
+        m_count = 0;
+    }
+
+private:
+    // Стоимость выводится как в iostream по умолчанию (%g с 6 значащими цифрами):
+    // 80 -> "80", 92.5 -> "92.5", 1234567 -> "1.23457e+06"
+    void AppendCost(double cost)
+    {
+        if (cost >= 0 && cost < 1e6 && cost == std::floor(cost) && !std::signbit(cost))
+        {
+            // Целые числа до миллиона %g выводит всеми цифрами
+            AppendUnsigned(static_cast<unsigned long long>(cost));
+            return;
+        }
+        char digits[32];
+        auto length = std::snprintf(digits, sizeof(digits), "%g", cost);
+        m_buffer.append(digits, static_cast<size_t>(length));
+    }
+
+    void AppendUnsigned(unsigned long long value)
+    {
+        char digits[20];
+        char * end = digits + sizeof(digits);
+        char * begin = end;
+        do
+        {
+            *--begin = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        m_buffer.append(begin, end);
+    }
+
+    // Описания напитков содержат запятые, поэтому в CSV поле всегда берется в кавычки
+    void AppendCsvField(const std::string & field)
+    {
+        m_buffer += '"';
+        for (char ch : field)
+        {
+            if (ch == '"')
+            {
+                m_buffer += '"';
+            }
+            m_buffer += ch;
+        }
+        m_buffer += '"';
+    }
+
+    void AppendJsonString(const std::string & str)
+    {
+        static const char HEX[] = "0123456789abcdef";
+        m_buffer += '"';
+        for (char ch : str)
+        {
+            switch (ch)
+            {
+                case '"':  m_buffer += "\\\""; break;
+                case '\\': m_buffer += "\\\\"; break;
+                case '\n': m_buffer += "\\n";  break;
+                case '\r': m_buffer += "\\r";  break;
+                case '\t': m_buffer += "\\t";  break;
+                default:
+                    if (static_cast<unsigned char>(ch) < 0x20)
+                    {
+                        m_buffer += "\\u00";
+                        m_buffer += HEX[(ch >> 4) & 0xF];
+                        m_buffer += HEX[ch & 0xF];
+                    }
+                    else
+                    {
+                        m_buffer += ch;
+                    }
+            }
+        }
+        m_buffer += '"';
+    }
+
+    static const size_t APPROX_LINE_LENGTH = 96;
+
+    ReceiptFormat m_format;
+    std::string m_buffer;
+    size_t m_count = 0;
+};
@@ -0,0 +1,238 @@
+﻿#include "Beverages.h"
+#include "Condiments.h"
+#include "Inventory.h"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/*
+Многопоточная проверка CInventory: Reserve, Commit, Cancel и GetSnapshot.
+*/
+
+namespace
+{
+
+atomic<int> g_failuresCount{0};
+
+void Check(bool condition, const string & what)
+{
+    if (!condition)
+    {
+        cerr << "FAILED: " << what << endl;
+        ++g_failuresCount;
+    }
+}
+
+CRecipe MakeRecipe(Ingredient ingredient, unsigned amount)
+{
+    CRecipe recipe;
+    recipe.Add(ingredient, amount);
+    return recipe;
+}
+
+void TestReservationIsAllOrNothing()
+{
+    CInventory inventory;
+    inventory.Restock(Ingredient::Lemon, 10);
+    inventory.Restock(Ingredient::Cream, 1);
+
+    CRecipe recipe = MakeRecipe(Ingredient::Lemon, 4);
+    recipe.Add(Ingredient::Cream, 2);
+    Check(!inventory.Reserve(recipe), "order is rejected when one ingredient runs out");
+    auto snapshot = inventory.GetSnapshot();
+    Check(snapshot.GetAvailable(Ingredient::Lemon) == 10, "rejected order returns everything it took");
+
+    auto reservation = inventory.Reserve(MakeRecipe(Ingredient::Lemon, 10));
+    Check(static_cast<bool>(reservation), "whole stock spread over shards can be reserved");
+    Check(inventory.GetSnapshot().GetAvailable(Ingredient::Lemon) == 0, "reserved stock is unavailable");
+    reservation.Cancel();
+    Check(inventory.GetSnapshot().GetAvailable(Ingredient::Lemon) == 10, "cancel returns stock");
+
+    {
+        auto committed = inventory.Reserve(MakeRecipe(Ingredient::Lemon, 3));
+        auto moved = std::move(committed);
+        Check(!committed && moved, "reservation is moved");
+        moved.Commit();
+    }
+    {
+        auto dropped = inventory.Reserve(MakeRecipe(Ingredient::Lemon, 2));
+    }
+    snapshot = inventory.GetSnapshot();
+    Check(snapshot.GetAvailable(Ingredient::Lemon) == 7, "commit keeps stock taken, destructor returns it");
+    Check(snapshot.GetConsumed(Ingredient::Lemon) == 3, "commit counts consumption");
+}
+
+// Заказ, на который не хватает запаса, не должен мешать заказам, на которые хватает
+void TestInfeasibleOrderDoesNotStarveOthers()
+{
+    CInventory inventory;
+    inventory.Restock(Ingredient::Lemon, 10);
+
+    atomic<bool> isDone{false};
+    vector<thread> greedyCustomers;
+    for (int i = 0; i < 3; ++i)
+    {
+        greedyCustomers.emplace_back([&] {
+            while (!isDone)
+            {
+                Check(!inventory.Reserve(MakeRecipe(Ingredient::Lemon, 20)), "20 lemons out of 10 are rejected");
+            }
+        });
+    }
+
+    unsigned rejectedCount = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        auto reservation = inventory.Reserve(MakeRecipe(Ingredient::Lemon, 5));
+        rejectedCount += reservation ? 0 : 1;
+    }
+    isDone = true;
+    for (auto & customer : greedyCustomers)
+    {
+        customer.join();
+    }
+    Check(rejectedCount == 0, "5 lemons out of 10 are always reserved, rejected "
+        + to_string(rejectedCount) + " times");
+}
+
+/*
+Запаса ровно столько, сколько одновременно держат все кассы: каждая касса держит не больше
+одного резерва (3 дольки лимона и 2 кубика сухого льда), поэтому ни один заказ не должен
+получить отказ, как бы резервы ни делили шарды между собой. Касс меньше, чем шардов,
+поэтому запас лежит в шардах неровно и резервам приходится забирать его из чужих шардов.
+*/
+void TestNoRefusalsWhileStockLasts()
+{
+    const unsigned cashiersCount = 6;
+    CInventory inventory;
+    inventory.Restock(Ingredient::Lemon, 3 * cashiersCount);
+    inventory.Restock(Ingredient::DryIceCubes, 2 * cashiersCount);
+
+    CRecipe recipe = MakeRecipe(Ingredient::Lemon, 3);
+    recipe.Add(Ingredient::DryIceCubes, 2);
+
+    atomic<unsigned> refusalsCount{0};
+    atomic<bool> isDone{false};
+    thread reporter([&] {
+        while (!isDone)
+        {
+            inventory.GetSnapshot();
+        }
+    });
+
+    vector<thread> cashiers;
+    for (unsigned i = 0; i < cashiersCount; ++i)
+    {
+        cashiers.emplace_back([&] {
+            for (int order = 0; order < 5000; ++order)
+            {
+                auto reservation = inventory.Reserve(recipe);
+                if (!reservation)
+                {
+                    ++refusalsCount;
+                }
+            }
+        });
+    }
+    for (auto & cashier : cashiers)
+    {
+        cashier.join();
+    }
+    isDone = true;
+    reporter.join();
+
+    Check(refusalsCount == 0, "no refusals while stock lasts, refused " + to_string(refusalsCount.load()) + " times");
+    auto snapshot = inventory.GetSnapshot();
+    Check(snapshot.GetAvailable(Ingredient::Lemon) == 3 * cashiersCount, "cancelled reservations return lemons");
+    Check(snapshot.GetAvailable(Ingredient::DryIceCubes) == 2 * cashiersCount, "cancelled reservations return ice");
+}
+
+/*
+Кассы параллельно резервируют лимонный чай со льдом (3 дольки лимона и 2 кубика сухого льда)
+и выдают или отменяют заказы, пока запас не кончится. Сводки, снятые в это время,
+не должны видеть половину резерва, а итог должен сходиться с числом выданных заказов.
+*/
+void TestConcurrentCheckoutsAndSnapshots()
+{
+    const unsigned long long lemons = 30000;
+    const unsigned long long iceCubes = 20000;
+    CInventory inventory;
+    inventory.Restock(Ingredient::Lemon, lemons);
+    inventory.Restock(Ingredient::DryIceCubes, iceCubes);
+
+    CIceCubes beverage(make_unique<CLemon>(make_unique<CTea>(), 3), 2, IceCubeType::Dry);
+    CRecipe recipe;
+    beverage.AddIngredients(recipe);
+
+    atomic<unsigned> committedCount{0};
+    atomic<bool> isDone{false};
+    atomic<unsigned> inconsistentSnapshotsCount{0};
+
+    thread reporter([&] {
+        while (!isDone)
+        {
+            auto snapshot = inventory.GetSnapshot();
+            auto reservedLemons = lemons - snapshot.GetAvailable(Ingredient::Lemon) - snapshot.GetConsumed(Ingredient::Lemon);
+            auto reservedIce = iceCubes - snapshot.GetAvailable(Ingredient::DryIceCubes) - snapshot.GetConsumed(Ingredient::DryIceCubes);
+            if (reservedLemons % 3 != 0 || reservedIce % 2 != 0 || reservedLemons / 3 != reservedIce / 2
+                || snapshot.GetConsumed(Ingredient::Lemon) / 3 != snapshot.GetConsumed(Ingredient::DryIceCubes) / 2)
+            {
+                ++inconsistentSnapshotsCount;
+            }
+        }
+    });
+
+    vector<thread> cashiers;
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        cashiers.emplace_back([&, i] {
+            for (unsigned order = 0; ; ++order)
+            {
+                auto reservation = inventory.Reserve(recipe);
+                if (!reservation)
+                {
+                    break;
+                }
+                if ((order + i) % 3 != 0)
+                {
+                    reservation.Commit();
+                    ++committedCount;
+                }
+            }
+        });
+    }
+    for (auto & cashier : cashiers)
+    {
+        cashier.join();
+    }
+    isDone = true;
+    reporter.join();
+
+    auto snapshot = inventory.GetSnapshot();
+    Check(inconsistentSnapshotsCount == 0, "snapshots never see a half-applied reservation");
+    Check(snapshot.GetConsumed(Ingredient::Lemon) == committedCount * 3ull, "consumed lemons match committed orders");
+    Check(snapshot.GetConsumed(Ingredient::DryIceCubes) == committedCount * 2ull, "consumed ice matches committed orders");
+    Check(snapshot.GetAvailable(Ingredient::Lemon) == lemons - committedCount * 3ull, "no lemons are lost");
+    Check(snapshot.GetAvailable(Ingredient::DryIceCubes) == iceCubes - committedCount * 2ull, "no ice cubes are lost");
+    Check(committedCount == 10000, "whole stock is sold, sold " + to_string(committedCount.load()));
+}
+
+}
+
+int main()
+{
+    TestReservationIsAllOrNothing();
+    TestInfeasibleOrderDoesNotStarveOthers();
+    TestNoRefusalsWhileStockLasts();
+    TestConcurrentCheckoutsAndSnapshots();
+    if (g_failuresCount != 0)
+    {
+        cerr << g_failuresCount << " inventory checks failed" << endl;
+        return 1;
+    }
+    cout << "All inventory checks passed" << endl;
+}
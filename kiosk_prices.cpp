@@ -0,0 +1,91 @@
+﻿#include "PriceMatrix.h"
+#include "ReceiptRenderer.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+/*
+Прайс-лист для киоска: каждый базовый напиток сам по себе и с каждой добавкой из меню.
+Цены берутся из CPriceMatrix, формат вывода - text (по умолчанию), csv или json.
+Использование: beverages_kiosk_prices [text|csv|json] [глубина таблицы] [бюджет памяти, КиБ]
+*/
+
+// Таблица по умолчанию укладывается в 16 МиБ
+const unsigned long long DEFAULT_MEMORY_BUDGET_KIB = 16 * 1024;
+
+// Разбирает неотрицательное целое не больше maxValue
+bool ParseUnsigned(const char * text, unsigned long long maxValue, unsigned long long & value)
+{
+    if (!isdigit(static_cast<unsigned char>(text[0])))
+    {
+        return false;
+    }
+    errno = 0;
+    char * end = nullptr;
+    value = strtoull(text, &end, 10);
+    return errno == 0 && *end == '\0' && value <= maxValue;
+}
+
+int main(int argc, char * argv[])
+{
+    auto format = ReceiptFormat::Text;
+    if (argc > 1)
+    {
+        string formatName = argv[1];
+        if (formatName == "csv")
+        {
+            format = ReceiptFormat::Csv;
+        }
+        else if (formatName == "json")
+        {
+            format = ReceiptFormat::Json;
+        }
+        else if (formatName != "text")
+        {
+            cerr << "Unknown format " << formatName << ", expected text, csv or json" << endl;
+            return 1;
+        }
+    }
+
+    unsigned long long depth = 1;
+    if (argc > 2 && !ParseUnsigned(argv[2], CPriceMatrix::MAX_DEPTH, depth))
+    {
+        cerr << "Invalid depth " << argv[2] << ", expected 0.." << CPriceMatrix::MAX_DEPTH << endl;
+        return 1;
+    }
+    unsigned long long budgetKiB = DEFAULT_MEMORY_BUDGET_KIB;
+    if (argc > 3 && !ParseUnsigned(argv[3], numeric_limits<size_t>::max() / 1024, budgetKiB))
+    {
+        cerr << "Invalid memory budget " << argv[3] << ", expected a size in KiB" << endl;
+        return 1;
+    }
+
+    CPriceMatrix prices(static_cast<unsigned>(depth), static_cast<size_t>(budgetKiB * 1024));
+    CReceiptRenderer priceList(format);
+    priceList.Reserve(BASE_BEVERAGE_OPTIONS_COUNT * (CONDIMENT_OPTIONS_COUNT + 1));
+    PriceQuote quote;
+    for (size_t base = 0; base < BASE_BEVERAGE_OPTIONS_COUNT; ++base)
+    {
+        MenuOrder order;
+        order.base = static_cast<BaseBeverageOption>(base);
+        if (prices.GetQuote(order, quote))
+        {
+            priceList.Add(quote.description, quote.cost);
+        }
+        for (size_t condiment = 0; condiment < CONDIMENT_OPTIONS_COUNT; ++condiment)
+        {
+            MenuOrder withCondiment = order;
+            withCondiment.Add(static_cast<CondimentOption>(condiment));
+            if (prices.GetQuote(withCondiment, quote))
+            {
+                priceList.Add(quote.description, quote.cost);
+            }
+        }
+    }
+    priceList.WriteTo(cout);
+}
@@ -1,5 +1,8 @@
 ﻿#include "Beverages.h"
 #include "Condiments.h"
+#include "Inventory.h"
+#include "Menu.h"
+#include "ReceiptRenderer.h"
 
 #include <iostream>
 #include <string>
@@ -112,67 +115,44 @@ auto operator << (Component && component, const Decorator & decorate)
 
 bool MakeBeverageChoice(unique_ptr<IBeverage> &beverage, int beverageChoice)
 {
-
+    int variantChoice = 0;
     switch (beverageChoice)
     {
         case 1:
-            beverage = make_unique<CCoffee>();
-            return true;
+            break;
         case 2:
             cout << "Choose Cappuccino portion (1 - Standard, 2 - Double): ";
-            int cappuccinoChoice;
-            cin >> cappuccinoChoice;
-            if (cappuccinoChoice > 4 or cappuccinoChoice < 1)
-            {
-                cout << "Invalid choice, go away from my cafe!";
-                return false;
-            }
-            beverage = make_unique<CCappuccino>(cappuccinoChoice != 1);
-            return true;
+            cin >> variantChoice;
+            break;
         case 3:
             cout << "Choose Latte portion (1 - Standard, 2 - Double): ";
-            int latteChoice;
-            cin >> latteChoice;
-            if (latteChoice > 4 or latteChoice < 1)
-            {
-                cout << "Invalid choice, go away from my cafe!";
-                return false;
-            }
-            beverage = make_unique<CLatte>(latteChoice != 1);
-            return true;
+            cin >> variantChoice;
+            break;
         case 4:
-        {
             cout << "Choose tea type (1 - Black, 2 - White, 3 - Blue, 4 - Cyan): ";
-            int teaChoice;
-            cin >> teaChoice;
-            if (teaChoice > 4 or teaChoice < 1)
-            {
-                cout << "Invalid choice, go away from my cafe!";
-                return false;
-            }
-            beverage = make_unique<CTea>(static_cast<TeaType>(teaChoice - 1));
-            return true;
-        }
+            cin >> variantChoice;
+            break;
         case 5:
-        {
             cout << "Choose milkshake size (1 - Small, 2 - Medium, 3 - Large): ";
-            int sizeChoice;
-            cin >> sizeChoice;
-            if (sizeChoice > 3 or sizeChoice < 1)
-            {
-                cout << "Invalid choice, go away from my cafe!";
-                return false;
-            }
-            beverage = make_unique<CMilkshake>(static_cast<MilkshakeSize>(sizeChoice - 1));
-            return true;
-        }
+            cin >> variantChoice;
+            break;
         default:
             cout << "Invalid choice, go away from my cafe!" << endl;
             return false;
     }
+
+    // Допустимые ответы и соответствующие им напитки описаны в меню (Menu.h)
+    BaseBeverageOption option;
+    if (!GetBaseBeverageOption(beverageChoice, variantChoice, option))
+    {
+        cout << "Invalid choice, go away from my cafe!";
+        return false;
+    }
+    beverage = MakeBaseBeverage(option);
+    return true;
 }
 
-bool MakeCondimentChoice(unique_ptr<IBeverage> &beverage, int condimentChoice)
+bool MakeCondimentChoice(unique_ptr<IBeverage> &beverage, int condimentChoice, CInventory &inventory)
 {
     switch (condimentChoice)
     {
@@ -228,16 +208,39 @@ bool MakeCondimentChoice(unique_ptr<IBeverage> &beverage, int condimentChoice)
                     (liqueurChoice == 1 ? LiqueurType::Nutty : LiqueurType::Chocolate);
             return true;
         case 0:
+        {
             cout << "Checkout!" << endl;
-            cout << beverage->GetDescription() << ", cost: " << beverage->GetCost() << endl;
+            CRecipe recipe;
+            beverage->AddIngredients(recipe);
+            auto reservation = inventory.Reserve(recipe);
+            if (!reservation)
+            {
+                cout << "Sorry, we are out of ingredients for your order." << endl;
+                return false;
+            }
+            reservation.Commit();
+            CReceiptRenderer receipt;
+            receipt.Add(*beverage);
+            receipt.WriteTo(cout);
+            cout.flush();
             return false;
+        }
         default:
             cout << "Invalid choice, try again." << endl;
             return true;
     }
 }
 
-void DialogWithUser()
+// Начальный запас ингредиентов на смену
+void FillInventory(CInventory &inventory)
+{
+    for (size_t index = 0; index < INGREDIENTS_COUNT; ++index)
+    {
+        inventory.Restock(static_cast<Ingredient>(index), 100);
+    }
+}
+
+void DialogWithUser(CInventory &inventory)
 {
     cout << "Welcome to the beverage ordering system!" << endl;
 
@@ -260,7 +263,7 @@ void DialogWithUser()
             int condimentChoice;
             cin >> condimentChoice;
 
-            choosingFlag = MakeCondimentChoice(beverage, condimentChoice);
+            choosingFlag = MakeCondimentChoice(beverage, condimentChoice, inventory);
         }
     }
 }
@@ -268,7 +271,9 @@ void DialogWithUser()
 
 int main()
 {
-	DialogWithUser();
+	CInventory inventory;
+	FillInventory(inventory);
+	DialogWithUser(inventory);
 	cout << endl;
 //	{
 //		// Наливаем чашечку латте
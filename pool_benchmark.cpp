@@ -0,0 +1,45 @@
+﻿#include "Beverages.h"
+#include "Condiments.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+/*
+Сравнение создания и уничтожения заказов с пулом узлов CNodePool и без него.
+Собирается дважды: beverages_pool_benchmark (с пулом) и
+beverages_pool_benchmark_unpooled (BEVERAGE_POOL_DISABLED, обычный make_unique).
+*/
+
+IBeveragePtr MakeOrder(unsigned i)
+{
+    IBeveragePtr beverage = make_unique<CTea>(static_cast<TeaType>(i % 4));
+    beverage = make_unique<CLemon>(std::move(beverage), i % 3 + 1);
+    beverage = make_unique<CCinnamon>(std::move(beverage));
+    beverage = make_unique<CIceCubes>(std::move(beverage), 2, i % 2 ? IceCubeType::Dry : IceCubeType::Water);
+    beverage = make_unique<CChocolateCrumbs>(std::move(beverage), 5);
+    beverage = make_unique<CSyrup>(std::move(beverage), SyrupType::Maple);
+    return beverage;
+}
+
+int main()
+{
+    const unsigned ordersCount = 2000000;
+    double totalCost = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (unsigned i = 0; i < ordersCount; ++i)
+    {
+        auto beverage = MakeOrder(i);
+        totalCost += beverage->GetCost();
+    }
+    auto elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start);
+
+#ifdef BEVERAGE_POOL_DISABLED
+    cout << "make_unique: ";
+#else
+    cout << "node pool:   ";
+#endif
+    cout << elapsed.count() / ordersCount << " ns per order (total cost " << totalCost << ")" << endl;
+}
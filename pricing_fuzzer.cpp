@@ -0,0 +1,365 @@
+﻿#include "PriceMatrix.h"
+#include "ReceiptRenderer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+/*
+Дифференциальный фаззер цен.
+
+Из входных байтов собирается случайный напиток, его цена и описание считаются эталонной
+цепочкой декораторов (IBeverage::GetCost/GetDescription) и сравниваются с результатами
+остальных путей расчета: CPriceMatrix (таблица и откат на живую цепочку),
+GetBaseBeverageOption/MakeBaseBeverage, через которые напиток выбирается в диалоге
+(MakeBeverageChoice), MakeBeverage из меню и CReceiptRenderer. При расхождении фаззер
+печатает подробности и вызывает abort().
+
+Сборка с libFuzzer (clang): -DBEVERAGES_LIBFUZZER=ON. Без libFuzzer собирается
+автономная программа: без аргументов прогоняет случайные входы, с аргументами -
+файлы входов (подходит для AFL: afl-fuzz -i in -o out -- beverages_pricing_fuzzer @@).
+*/
+
+namespace
+{
+
+class CInputReader
+{
+public:
+    CInputReader(const uint8_t * data, size_t size)
+        : m_data(data), m_size(size)
+    {}
+
+    bool IsAtEnd() const
+    {
+        return m_pos >= m_size;
+    }
+
+    uint8_t Next()
+    {
+        return m_pos < m_size ? m_data[m_pos++] : 0;
+    }
+private:
+    const uint8_t * m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+};
+
+// Выбор, который фаззер добавляет к пунктам меню: молочный коктейль любого размера,
+// в том числе вне MilkshakeSize
+const int RAW_MILKSHAKE_CHOICE = 6;
+
+// Эталонный базовый напиток - проверки ответов и конструкторы в том виде, в каком их
+// исходно выполнял MakeBeverageChoice; сейчас диалог работает через GetBaseBeverageOption
+IBeveragePtr MakeReferenceBase(int beverageChoice, int variantChoice)
+{
+    switch (beverageChoice)
+    {
+        case 1:
+            return make_unique<CCoffee>();
+        case 2:
+            if (variantChoice > 4 or variantChoice < 1)
+            {
+                return nullptr;
+            }
+            return make_unique<CCappuccino>(variantChoice != 1);
+        case 3:
+            if (variantChoice > 4 or variantChoice < 1)
+            {
+                return nullptr;
+            }
+            return make_unique<CLatte>(variantChoice != 1);
+        case 4:
+            if (variantChoice > 4 or variantChoice < 1)
+            {
+                return nullptr;
+            }
+            return make_unique<CTea>(static_cast<TeaType>(variantChoice - 1));
+        case 5:
+            if (variantChoice > 3 or variantChoice < 1)
+            {
+                return nullptr;
+            }
+            return make_unique<CMilkshake>(static_cast<MilkshakeSize>(variantChoice - 1));
+        case RAW_MILKSHAKE_CHOICE:
+            return make_unique<CMilkshake>(static_cast<MilkshakeSize>(variantChoice));
+        default:
+            return nullptr;
+    }
+}
+
+// Добавка с произвольными параметрами
+struct Condiment
+{
+    unsigned kind;
+    unsigned amount;
+    unsigned variant;
+};
+
+const unsigned CONDIMENT_KINDS_COUNT = 9;
+const size_t MAX_CONDIMENTS = 24;
+
+IBeveragePtr AddReferenceCondiment(IBeveragePtr && beverage, const Condiment & condiment)
+{
+    switch (condiment.kind)
+    {
+        case 0: return make_unique<CCinnamon>(std::move(beverage));
+        case 1: return make_unique<CLemon>(std::move(beverage), condiment.amount);
+        case 2: return make_unique<CIceCubes>(std::move(beverage), condiment.amount,
+                    condiment.variant ? IceCubeType::Dry : IceCubeType::Water);
+        case 3: return make_unique<CSyrup>(std::move(beverage),
+                    condiment.variant ? SyrupType::Chocolate : SyrupType::Maple);
+        case 4: return make_unique<CChocolateCrumbs>(std::move(beverage), condiment.amount);
+        case 5: return make_unique<CCoconutFlakes>(std::move(beverage), condiment.amount);
+        case 6: return make_unique<CCream>(std::move(beverage));
+        case 7: return make_unique<CChocolateSlices>(std::move(beverage), condiment.amount);
+        default: return make_unique<CLiqueur>(std::move(beverage),
+                    condiment.variant ? LiqueurType::Chocolate : LiqueurType::Nutty);
+    }
+}
+
+// Пункт меню, соответствующий добавке; false - такой порции в меню нет
+bool GetCondimentOption(const Condiment & condiment, CondimentOption & option)
+{
+    switch (condiment.kind)
+    {
+        case 0:
+            option = CondimentOption::Cinnamon;
+            return true;
+        case 1:
+            option = CondimentOption::Lemon;
+            return condiment.amount == 2;
+        case 2:
+            option = condiment.variant ? CondimentOption::DryIceCubes : CondimentOption::WaterIceCubes;
+            return condiment.amount == 2;
+        case 3:
+            option = condiment.variant ? CondimentOption::ChocolateSyrup : CondimentOption::MapleSyrup;
+            return true;
+        case 4:
+            option = CondimentOption::ChocolateCrumbs;
+            return condiment.amount == 5;
+        case 5:
+            option = CondimentOption::CoconutFlakes;
+            return condiment.amount == 5;
+        case 6:
+            option = CondimentOption::Cream;
+            return true;
+        case 7:
+            option = CondimentOption::ChocolateSlices;
+            return condiment.amount == 1;
+        default:
+            option = condiment.variant ? CondimentOption::ChocolateLiqueur : CondimentOption::NuttyLiqueur;
+            return true;
+    }
+}
+
+void Check(bool condition, const char * what, const string & details)
+{
+    if (!condition)
+    {
+        cerr << "Pricing mismatch: " << what << endl << details << endl;
+        abort();
+    }
+}
+
+string FormatCost(double cost)
+{
+    ostringstream out;
+    out << cost;
+    return out.str();
+}
+
+// Эталонная цена; false, если эталонная цепочка бросает исключение
+bool TryGetCost(const IBeverage & beverage, double & cost)
+{
+    try
+    {
+        cost = beverage.GetCost();
+        return true;
+    }
+    catch (const invalid_argument &)
+    {
+        return false;
+    }
+}
+
+void CheckReceipt(const string & description, double cost)
+{
+    CReceiptRenderer receipt;
+    receipt.Add(description, cost);
+    ostringstream actual;
+    receipt.WriteTo(actual);
+    auto expected = description + ", cost: " + FormatCost(cost) + "\n";
+    Check(actual.str() == expected, "receipt line", "expected: " + expected + "actual:   " + actual.str());
+}
+
+void CheckPriceMatrix(const CPriceMatrix & matrix, const MenuOrder & order,
+        const string & expectedDescription, double expectedCost)
+{
+    PriceQuote quote;
+    double cost = 0;
+    bool isQuoted = matrix.GetQuote(order, quote);
+    bool isCosted = matrix.GetCost(order, cost);
+    auto details = "expected: " + expectedDescription + ", cost: " + FormatCost(expectedCost)
+        + "\nactual:   " + quote.description + ", cost: " + FormatCost(quote.cost)
+        + (matrix.Contains(order) ? " (table)" : " (fallback)");
+    Check(isQuoted && isCosted, "price matrix rejects menu order", details);
+    Check(quote.cost == expectedCost, "price matrix cost", details);
+    Check(quote.description == expectedDescription, "price matrix description", details);
+    Check(cost == expectedCost, "price matrix GetCost", details);
+
+    // Напиток не из меню не должен получить цену
+    MenuOrder unknownOrder = order;
+    unknownOrder.base = static_cast<BaseBeverageOption>(BASE_BEVERAGE_OPTIONS_COUNT + static_cast<size_t>(order.base));
+    Check(!matrix.GetQuote(unknownOrder, quote) && !matrix.GetCost(unknownOrder, cost),
+        "price matrix quotes unknown base beverage", details);
+}
+
+const CPriceMatrix & GetFullMatrix()
+{
+    static const CPriceMatrix matrix(3);
+    return matrix;
+}
+
+// Таблица, обрезанная бюджетом памяти, - часть заказов идет по откату на живую цепочку
+const CPriceMatrix & GetBudgetMatrix()
+{
+    static const CPriceMatrix matrix(6, 256 * 1024);
+    return matrix;
+}
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size)
+{
+    CInputReader input(data, size);
+    int beverageChoice = input.Next() % 7;
+    int variantChoice = static_cast<int>(input.Next() % 7) - 1;
+
+    auto reference = MakeReferenceBase(beverageChoice, variantChoice);
+    BaseBeverageOption baseOption = BaseBeverageOption::Coffee;
+    bool isMenuBase = GetBaseBeverageOption(beverageChoice, variantChoice, baseOption);
+    if (beverageChoice != RAW_MILKSHAKE_CHOICE)
+    {
+        Check(isMenuBase == (reference != nullptr), "menu choice acceptance",
+            "beverage " + to_string(beverageChoice) + ", variant " + to_string(variantChoice));
+    }
+    if (!reference)
+    {
+        return 0;
+    }
+    if (isMenuBase)
+    {
+        // Напиток, который диалог выдает на этот выбор
+        auto served = MakeBaseBeverage(baseOption);
+        auto details = "expected: " + reference->GetDescription() + "\nactual:   " + served->GetDescription();
+        Check(served->GetDescription() == reference->GetDescription(), "menu base description", details);
+        Check(served->GetCost() == reference->GetCost(), "menu base cost", details);
+    }
+
+    vector<Condiment> condiments;
+    while (!input.IsAtEnd() && condiments.size() < MAX_CONDIMENTS)
+    {
+        Condiment condiment;
+        condiment.kind = input.Next() % CONDIMENT_KINDS_COUNT;
+        condiment.amount = input.Next();
+        condiment.variant = input.Next() & 1;
+        condiments.push_back(condiment);
+        reference = AddReferenceCondiment(std::move(reference), condiment);
+    }
+
+    auto description = reference->GetDescription();
+    double cost = 0;
+    bool isOutOfRangeMilkshake = beverageChoice == RAW_MILKSHAKE_CHOICE
+        && (variantChoice < 0 || variantChoice > static_cast<int>(MilkshakeSize::Large));
+    Check(TryGetCost(*reference, cost) != isOutOfRangeMilkshake, "milkshake size range", description);
+    if (isOutOfRangeMilkshake)
+    {
+        Check(description.find("Unknown Size Milkshake") == 0, "milkshake description", description);
+        return 0;
+    }
+
+    CheckReceipt(description, cost);
+
+    // Таблица цен знает только пункты меню
+    if (!isMenuBase)
+    {
+        return 0;
+    }
+    MenuOrder order;
+    order.base = baseOption;
+    vector<pair<CondimentOption, Condiment>> menuCondiments;
+    for (auto & condiment : condiments)
+    {
+        CondimentOption option;
+        if (!GetCondimentOption(condiment, option))
+        {
+            return 0;
+        }
+        order.Add(option);
+        menuCondiments.emplace_back(option, condiment);
+    }
+
+    // Таблица описывает добавки в порядке CondimentOption - эталон собирается в том же порядке
+    stable_sort(menuCondiments.begin(), menuCondiments.end(), [](const pair<CondimentOption, Condiment> & lhs,
+            const pair<CondimentOption, Condiment> & rhs) {
+        return lhs.first < rhs.first;
+    });
+    auto canonical = MakeReferenceBase(beverageChoice, variantChoice);
+    for (auto & condiment : menuCondiments)
+    {
+        canonical = AddReferenceCondiment(std::move(canonical), condiment.second);
+    }
+    auto canonicalDescription = canonical->GetDescription();
+    Check(canonical->GetCost() == cost, "cost depends on condiment order", description);
+
+    CheckPriceMatrix(GetFullMatrix(), order, canonicalDescription, cost);
+    CheckPriceMatrix(GetBudgetMatrix(), order, canonicalDescription, cost);
+    return 0;
+}
+
+#ifndef BEVERAGES_LIBFUZZER
+int main(int argc, char * argv[])
+{
+    if (argc > 1)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            ifstream file(argv[i], ios::binary);
+            if (!file)
+            {
+                cerr << "Can't open " << argv[i] << endl;
+                return 1;
+            }
+            vector<uint8_t> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+            LLVMFuzzerTestOneInput(data.data(), data.size());
+        }
+        return 0;
+    }
+
+    const unsigned runsCount = 200000;
+    mt19937 random(20241018);
+    uniform_int_distribution<int> byte(0, 255);
+    vector<uint8_t> data;
+    for (unsigned run = 0; run < runsCount; ++run)
+    {
+        data.resize(random() % 40);
+        for (auto & value : data)
+        {
+            // Чаще выбираем порции из меню, чтобы проверять таблицу цен, а не только откат
+            value = static_cast<uint8_t>(byte(random) % (run % 2 ? 256 : 8));
+        }
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    cout << "No pricing mismatches in " << runsCount << " random drinks" << endl;
+}
+#endif
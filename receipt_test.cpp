@@ -0,0 +1,138 @@
+﻿#include "Beverages.h"
+#include "Condiments.h"
+#include "ReceiptRenderer.h"
+
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+using namespace std;
+
+/*
+Проверка CReceiptRenderer во всех трех форматах: формат стоимости, экранирование описаний,
+заголовки и скобки пакетов.
+*/
+
+namespace
+{
+
+int g_failuresCount = 0;
+
+void CheckEqual(const string & actual, const string & expected, const string & what)
+{
+    if (actual != expected)
+    {
+        cerr << "FAILED: " << what << endl
+            << "expected: " << expected << endl
+            << "actual:   " << actual << endl;
+        ++g_failuresCount;
+    }
+}
+
+string Render(CReceiptRenderer & receipt)
+{
+    ostringstream out;
+    receipt.WriteTo(out);
+    return out.str();
+}
+
+const double NAN_COST = numeric_limits<double>::quiet_NaN();
+const double INF_COST = numeric_limits<double>::infinity();
+
+// Стоимости, для которых проверяется совпадение с `cout << cost`
+const double COSTS[] = {
+    0, -0.0, 60, 92.5, 12.35, 0.001, 1.0 / 3, 999999, 1e6, 1234567, 123456.7, 1.8e17, 1e300,
+    -5, -12.5, NAN_COST, INF_COST, -INF_COST,
+};
+
+void TestTextCostMatchesIostream()
+{
+    for (double cost : COSTS)
+    {
+        CReceiptRenderer receipt;
+        receipt.Add("Coffee", cost);
+        ostringstream expected;
+        expected << "Coffee, cost: " << cost << "\n";
+        CheckEqual(Render(receipt), expected.str(), "text cost formatting");
+    }
+}
+
+void TestTextReceipt()
+{
+    CReceiptRenderer receipt;
+    CheckEqual(Render(receipt), "", "empty text batch");
+
+    CLemon beverage(make_unique<CLatte>(), 3);
+    receipt.Add(beverage);
+    receipt.Add("Tea", 30);
+    CheckEqual(Render(receipt), "Standard Latte, Lemon x 3, cost: 120\nTea, cost: 30\n", "text receipt");
+    CheckEqual(Render(receipt), "", "text buffer is cleared after WriteTo");
+}
+
+void TestCsvReceipt()
+{
+    CReceiptRenderer receipt(ReceiptFormat::Csv);
+    CheckEqual(Render(receipt), "", "empty csv batch");
+
+    receipt.Add("Coffee, Cinnamon", 80);
+    receipt.Add("Say \"cheese\"", 12.35);
+    receipt.Add("Back\\slash\nnew line", -5);
+    receipt.Add("Big", 1234567);
+    receipt.Add("Nan", NAN_COST);
+    receipt.Add("Inf", INF_COST);
+    CheckEqual(Render(receipt),
+        "order,description,cost\n"
+        "1,\"Coffee, Cinnamon\",80\n"
+        "2,\"Say \"\"cheese\"\"\",12.35\n"
+        "3,\"Back\\slash\nnew line\",-5\n"
+        "4,\"Big\",1.23457e+06\n"
+        "5,\"Nan\",nan\n"
+        "6,\"Inf\",inf\n",
+        "csv receipt");
+
+    receipt.Add("Tea", 30);
+    CheckEqual(Render(receipt), "order,description,cost\n1,\"Tea\",30\n", "csv header and numbering restart after WriteTo");
+}
+
+void TestJsonReceipt()
+{
+    CReceiptRenderer receipt(ReceiptFormat::Json);
+    CheckEqual(Render(receipt), "[]\n", "empty json batch");
+
+    receipt.Add("Say \"cheese\"", 92.5);
+    receipt.Add("Back\\slash\tand\nnew line\r\x01", 0.001);
+    receipt.Add("Big", 1e6);
+    receipt.Add("Negative", -12.5);
+    receipt.Add("Nan", NAN_COST);
+    receipt.Add("Inf", -INF_COST);
+    CheckEqual(Render(receipt),
+        "[\n"
+        "{\"order\":1,\"description\":\"Say \\\"cheese\\\"\",\"cost\":92.5},\n"
+        "{\"order\":2,\"description\":\"Back\\\\slash\\tand\\nnew line\\r\\u0001\",\"cost\":0.001},\n"
+        "{\"order\":3,\"description\":\"Big\",\"cost\":1e+06},\n"
+        "{\"order\":4,\"description\":\"Negative\",\"cost\":-12.5},\n"
+        "{\"order\":5,\"description\":\"Nan\",\"cost\":null},\n"
+        "{\"order\":6,\"description\":\"Inf\",\"cost\":null}\n"
+        "]\n",
+        "json receipt");
+
+    receipt.Add("Tea", 30);
+    CheckEqual(Render(receipt), "[\n{\"order\":1,\"description\":\"Tea\",\"cost\":30}\n]\n", "json batch restarts after WriteTo");
+    CheckEqual(Render(receipt), "[]\n", "json buffer is cleared after WriteTo");
+}
+
+}
+
+int main()
+{
+    TestTextCostMatchesIostream();
+    TestTextReceipt();
+    TestCsvReceipt();
+    TestJsonReceipt();
+    if (g_failuresCount != 0)
+    {
+        cerr << g_failuresCount << " receipt checks failed" << endl;
+        return 1;
+    }
+    cout << "All receipt checks passed" << endl;
+}